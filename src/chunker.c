@@ -0,0 +1,275 @@
+/**
+ * File:       chunker.c
+ * Author:     Franklyn Dahlberg
+ * Created:    18 October, 2026
+ * Copyright:  2026 (c) Franklyn Dahlberg
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "sha256_summer.h"
+#include "chunker.h"
+#include "worker_pool.h"
+
+/**
+ * Splits a file into content defined chunks (FastCDC style, using a gear
+ * rolling hash) and hashes each chunk with SHA-256.  Since boundaries depend
+ * on the content rather than on fixed offsets, inserting or removing bytes
+ * only changes the chunks around the edit, which is what makes the chunk
+ * digests useful as dedup keys.
+ *
+ * The file is read once.  The reader finds boundaries and hands each chunk
+ * off to a worker pool to be hashed while it keeps reading.  Manifest entries
+ * are written out in file order as soon as every chunk before them has been
+ * hashed, so memory use doesn't grow with the size of the file.
+ */
+
+const int CHUNK_READ_BUFFER_SIZE = 1024 * 1024;
+
+// A chunk waiting to be, or that has been, hashed by a worker.  Jobs are
+// kept in a list in file order until their manifest entry is written.
+typedef struct _ChunkJob {
+    ChunkEntry entry;
+    uint8_t *chunkData;
+    bool hashed;                 // Set by the worker, guarded by chunkJobLock
+    struct _ChunkJob *nextJob;
+} ChunkJob;
+
+// Guards the hashed flag of every ChunkJob
+pthread_mutex_t chunkJobLock = PTHREAD_MUTEX_INITIALIZER;
+
+// Random value for each possible byte, mixed into the rolling hash
+uint64_t gearTable[256];
+
+/**
+ * Fills out the gear table.  The values only need to be random looking and
+ * the same on every run, so they are generated with splitmix64 from a fixed
+ * seed rather than spelled out.
+ */
+static void initGearTable() {
+    uint64_t seed = 0x5348413235364344ULL;
+    for (int i = 0; i < 256; i++) {
+        seed += 0x9e3779b97f4a7c15ULL;
+        uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        gearTable[i] = z ^ (z >> 31);
+    }
+}
+
+/**
+ * Worker pool job, hashes a single chunk and frees its data.
+ *
+ * @param jobArg ChunkJob to hash
+ */
+static void hashChunkJob(void *jobArg) {
+    ChunkJob *job = (ChunkJob*)jobArg;
+    shaProcessBuffer(job->chunkData, job->entry.length, job->entry.digest);
+    free(job->chunkData);
+    job->chunkData = NULL;
+
+    pthread_mutex_lock(&chunkJobLock);
+    job->hashed = true;
+    pthread_mutex_unlock(&chunkJobLock);
+}
+
+/**
+ * Writes the param value to the file as a little endian integer of the
+ * param number of bytes.
+ */
+static void writeLittleEndian(FILE* filePointer, uint64_t value, int byteCount) {
+    for (int i = 0; i < byteCount; i++) {
+        fputc((value >> (i * 8)) & 0xff, filePointer);
+    }
+}
+
+/**
+ * Writes a single manifest entry (see chunker.h for the layout).
+ *
+ * @param manifestPointer manifest to write to
+ * @param entry hashed chunk to write
+ */
+static void writeManifestEntry(FILE* manifestPointer, ChunkEntry *entry) {
+    writeLittleEndian(manifestPointer, entry->offset, 8);
+    writeLittleEndian(manifestPointer, entry->length, 4);
+
+    // The digest goes out in the same byte order it is printed in
+    for (int j = 0; j < 8; j++) {
+        fputc((entry->digest[j] >> 24) & 0xff, manifestPointer);
+        fputc((entry->digest[j] >> 16) & 0xff, manifestPointer);
+        fputc((entry->digest[j] >> 8) & 0xff, manifestPointer);
+        fputc(entry->digest[j] & 0xff, manifestPointer);
+    }
+}
+
+/**
+ * Writes out and frees every job at the front of the list that has been
+ * hashed, stopping at the first one that hasn't.
+ *
+ * @param manifestPointer manifest to write to
+ * @param firstJob head of the job list, updated to the first job left
+ * @param lastJob tail of the job list, cleared if the list empties
+ */
+static void writeHashedChunks(FILE* manifestPointer, ChunkJob **firstJob, ChunkJob **lastJob) {
+    while (*firstJob != NULL) {
+        pthread_mutex_lock(&chunkJobLock);
+        bool hashed = (*firstJob)->hashed;
+        pthread_mutex_unlock(&chunkJobLock);
+        if (!hashed) {
+            break;
+        }
+
+        ChunkJob *job = *firstJob;
+        writeManifestEntry(manifestPointer, &job->entry);
+        *firstJob = job->nextJob;
+        free(job);
+    }
+
+    if (*firstJob == NULL) {
+        *lastJob = NULL;
+    }
+}
+
+/**
+ * Chunks the param file, hashes every chunk, and writes out a manifest of
+ * the offset, length and digest of each chunk.
+ *
+ * @param filePath path to the file to chunk
+ * @param manifestPath path to write the manifest to
+ */
+void chunkFile(char* filePath, char* manifestPath) {
+    FILE* filePointer = fopen(filePath, "rb");
+    if (filePointer == NULL) {
+        printf("Error opening file: %s\nExiting.\n\n", filePath);
+        exit(3);
+    }
+
+    // The header is written with placeholder size and count, and filled in
+    // once the whole file has been chunked.
+    FILE* manifestPointer = fopen(manifestPath, "wb");
+    if (manifestPointer == NULL) {
+        printf("Error opening manifest: %s\nExiting.\n\n", manifestPath);
+        exit(3);
+    }
+    fwrite(CHUNK_MANIFEST_MAGIC, 1, 8, manifestPointer);
+    writeLittleEndian(manifestPointer, 0, 8);
+    writeLittleEndian(manifestPointer, 0, 8);
+
+    initGearTable();
+
+    WorkerPool pool;
+    int threadCount = workerPoolDefaultThreadCount();
+    workerPoolCreate(&pool, threadCount, threadCount * 4);
+
+    uint8_t *readBuffer = malloc(CHUNK_READ_BUFFER_SIZE);
+    uint8_t *chunkBuffer = malloc(CHUNK_MAX_SIZE);
+    ChunkJob *firstJob = NULL;   // Oldest chunk not yet written to the manifest
+    ChunkJob *lastJob = NULL;
+    if (readBuffer == NULL || chunkBuffer == NULL) {
+        printf("Error allocating chunk buffers.\nExiting.\n\n");
+        exit(4);
+    }
+
+    uint64_t chunkCount = 0;
+    uint64_t chunkOffset = 0;    // Offset of the current chunk in the file
+    uint32_t chunkLength = 0;    // Bytes scanned into the current chunk
+    uint32_t chunkCopied = 0;    // Bytes copied into chunkBuffer
+    uint64_t gearHash = 0;
+    bool endOfChunk = false;
+    size_t bytesRead;
+
+    do {
+        bytesRead = fread(readBuffer, 1, CHUNK_READ_BUFFER_SIZE, filePointer);
+        size_t position = 0;
+
+        // At EOF, whatever is left over is the last chunk
+        if (bytesRead == 0 && chunkLength > 0) {
+            endOfChunk = true;
+        }
+
+        while (position < bytesRead || endOfChunk) {
+            // Scan forward until a boundary or the end of the read buffer.
+            // The hash doesn't start until the min size, since there can't be
+            // a boundary before then.
+            size_t spanStart = position;
+            while (position < bytesRead && !endOfChunk) {
+                chunkLength++;
+                if (chunkLength > CHUNK_MIN_SIZE) {
+                    gearHash = (gearHash << 1) + gearTable[readBuffer[position]];
+                    uint64_t mask = (chunkLength < CHUNK_AVG_SIZE) ? 
+                        CHUNK_MASK_SMALL : CHUNK_MASK_LARGE;
+                    endOfChunk = ((gearHash & mask) == 0) || 
+                        (chunkLength == CHUNK_MAX_SIZE);
+                }
+                position++;
+            }
+            memcpy(&chunkBuffer[chunkCopied], &readBuffer[spanStart], position - spanStart);
+            chunkCopied += position - spanStart;
+
+            if (!endOfChunk) {
+                break;
+            }
+
+            // Hand the chunk off to be hashed, and start a new one
+            ChunkJob *job = malloc(sizeof(ChunkJob));
+            if (job == NULL) {
+                printf("Error allocating chunk buffers.\nExiting.\n\n");
+                exit(4);
+            }
+            job->entry.offset = chunkOffset;
+            job->entry.length = chunkLength;
+            job->chunkData = chunkBuffer;
+            job->hashed = false;
+            job->nextJob = NULL;
+            if (lastJob == NULL) {
+                firstJob = job;
+            } else {
+                lastJob->nextJob = job;
+            }
+            lastJob = job;
+            chunkCount++;
+            workerPoolSubmit(&pool, hashChunkJob, job);
+            writeHashedChunks(manifestPointer, &firstJob, &lastJob);
+
+            chunkBuffer = malloc(CHUNK_MAX_SIZE);
+            if (chunkBuffer == NULL) {
+                printf("Error allocating chunk buffers.\nExiting.\n\n");
+                exit(4);
+            }
+            chunkOffset += chunkLength;
+            chunkLength = 0;
+            chunkCopied = 0;
+            gearHash = 0;
+            endOfChunk = false;
+        }
+    }while (bytesRead > 0);
+
+    if (ferror(filePointer)) {
+        printf("Error reading file: %s\nExiting.\n\n", filePath);
+        exit(3);
+    }
+    fclose(filePointer);
+
+    workerPoolWait(&pool);
+    workerPoolDestroy(&pool);
+    writeHashedChunks(manifestPointer, &firstJob, &lastJob);
+
+    fseek(manifestPointer, 8, SEEK_SET);
+    writeLittleEndian(manifestPointer, chunkOffset, 8);
+    writeLittleEndian(manifestPointer, chunkCount, 8);
+    if (ferror(manifestPointer) || fclose(manifestPointer) != 0) {
+        printf("Error writing manifest: %s\nExiting.\n\n", manifestPath);
+        exit(3);
+    }
+
+    printf("%llu chunks from %llu bytes written to %s\n", 
+            (unsigned long long)chunkCount, (unsigned long long)chunkOffset, manifestPath);
+
+    free(chunkBuffer);
+    free(readBuffer);
+}
@@ -0,0 +1,39 @@
+/**
+ * File:       chunker.h
+ * Author:     Franklyn Dahlberg
+ * Created:    18 October, 2026
+ * Copyright:  2026 (c) Franklyn Dahlberg
+ */
+
+#pragma once
+#include <stdint.h>
+
+// Chunk size limits, in bytes.  Boundaries are content defined, so actual
+// chunk sizes vary, but they are always between the min and max sizes and
+// tend towards the average size.
+#define CHUNK_MIN_SIZE (2 * 1024)
+#define CHUNK_AVG_SIZE (8 * 1024)
+#define CHUNK_MAX_SIZE (64 * 1024)
+
+// Normalized chunking masks.  Before the average size is reached the mask
+// has more bits set (boundaries are less likely), after it has fewer bits
+// set (boundaries are more likely).  This keeps chunk sizes clustered around
+// the average.  The high bits are used since they depend on the most bytes
+// in the gear hash.
+#define CHUNK_MASK_SMALL 0xfffe000000000000ULL   // 15 bits
+#define CHUNK_MASK_LARGE 0xffe0000000000000ULL   // 11 bits
+
+// Manifest layout, all integers little endian:
+//  Header: 8 byte magic, uint64 file size, uint64 chunk count
+//  Entry:  uint64 offset, uint32 length, 32 byte digest
+#define CHUNK_MANIFEST_MAGIC "SHA256CM"
+
+// A single chunk of the file and its digest
+typedef struct _ChunkEntry {
+    uint64_t offset;
+    uint32_t length;
+    uint32_t digest[8];
+} ChunkEntry;
+
+// Function declarations
+void chunkFile(char* filePath, char* manifestPath);
@@ -0,0 +1,357 @@
+/**
+ * File:       dupe_finder.c
+ * Author:     Franklyn Dahlberg
+ * Created:    18 October, 2026
+ * Copyright:  2026 (c) Franklyn Dahlberg
+ */
+
+#define _XOPEN_SOURCE 700
+
+#include <fcntl.h>
+#include <ftw.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "sha256_summer.h"
+#include "dupe_finder.h"
+#include "worker_pool.h"
+
+/**
+ * Finds duplicate files without hashing every byte of every file.  Files
+ * are narrowed down in stages, each one more expensive than the last, and
+ * only files that still collide move on to the next stage:
+ *  1. Files are grouped by size.  A file with a unique size can't have a
+ *     duplicate, and costs nothing more than a stat.
+ *  2. Within a size group, only the first and last DUPE_PARTIAL_SIZE bytes
+ *     are hashed.  Files that differ usually differ near one of the ends
+ *     (headers, trailers, appended data).
+ *  3. Files that still collide are hashed in full.
+ * The partial and full hash stages run on a worker pool.
+ *
+ * Files are identified by device and inode, so a file reached through
+ * overlapping search paths, or through several hard links, is only counted
+ * once and is never reported as a duplicate of itself.
+ */
+
+// Every regular file found under the search paths.  This is a global since
+// nftw doesn't pass any user data to its callback.
+DupeFile *dupeFiles;
+int dupeFileCount;
+int dupeFileCapacity;
+
+// Bytes read by the hashing stages, and the size of every file searched,
+// for the summary.  Files that make it to stage three have their ends read
+// twice, so bytesRead can exceed bytesTotal on small trees.
+long long bytesRead;
+long long bytesTotal;
+
+/**
+ * nftw callback, adds every regular file to dupeFiles.  Symbolic links
+ * aren't followed, so nothing is counted twice through a link.
+ */
+static int collectFile(const char *filePath, const struct stat *fileStat, int typeFlag,
+        struct FTW *ftwBuffer) {
+    if (typeFlag == FTW_DNR) {
+        fprintf(stderr, "Skipping unreadable directory: %s\n", filePath);
+        return 0;
+    }
+    if (typeFlag != FTW_F || !S_ISREG(fileStat->st_mode)) {
+        return 0;
+    }
+
+    if (dupeFileCount == dupeFileCapacity) {
+        dupeFileCapacity = (dupeFileCapacity == 0) ? 1024 : dupeFileCapacity * 2;
+        dupeFiles = realloc(dupeFiles, sizeof(DupeFile) * dupeFileCapacity);
+        if (dupeFiles == NULL) {
+            printf("Error allocating file list.\nExiting.\n\n");
+            exit(4);
+        }
+    }
+
+    DupeFile *dupeFile = &dupeFiles[dupeFileCount];
+    memset(dupeFile, 0, sizeof(DupeFile));
+    dupeFile->filePath = strdup(filePath);
+    dupeFile->fileSize = fileStat->st_size;
+    dupeFile->fileDevice = fileStat->st_dev;
+    dupeFile->fileInode = fileStat->st_ino;
+    dupeFileCount++;
+
+    return 0;
+}
+
+/**
+ * Orders files by device, then by inode, then by the order they were
+ * found in.  Consecutive files with the same device and inode are the same
+ * file.
+ */
+static int compareIdentity(const void *a, const void *b) {
+    const DupeFile *fileA = *(const DupeFile**)a;
+    const DupeFile *fileB = *(const DupeFile**)b;
+    if (fileA->fileDevice != fileB->fileDevice) {
+        return (fileA->fileDevice < fileB->fileDevice) ? -1 : 1;
+    }
+    if (fileA->fileInode != fileB->fileInode) {
+        return (fileA->fileInode < fileB->fileInode) ? -1 : 1;
+    }
+    if (fileA != fileB) {
+        return (fileA < fileB) ? -1 : 1;
+    }
+    return 0;
+}
+
+/**
+ * Orders files by size.
+ */
+static int compareSize(const void *a, const void *b) {
+    const DupeFile *fileA = *(const DupeFile**)a;
+    const DupeFile *fileB = *(const DupeFile**)b;
+    if (fileA->fileSize != fileB->fileSize) {
+        return (fileA->fileSize < fileB->fileSize) ? -1 : 1;
+    }
+    return 0;
+}
+
+/**
+ * Orders files by size, then by partial digest.
+ */
+static int comparePartial(const void *a, const void *b) {
+    const DupeFile *fileA = *(const DupeFile**)a;
+    const DupeFile *fileB = *(const DupeFile**)b;
+    if (fileA->fileSize != fileB->fileSize) {
+        return (fileA->fileSize < fileB->fileSize) ? -1 : 1;
+    }
+    return memcmp(fileA->partialDigest, fileB->partialDigest, sizeof(fileA->partialDigest));
+}
+
+/**
+ * Orders files by size, then by full digest.
+ */
+static int compareFull(const void *a, const void *b) {
+    const DupeFile *fileA = *(const DupeFile**)a;
+    const DupeFile *fileB = *(const DupeFile**)b;
+    if (fileA->fileSize != fileB->fileSize) {
+        return (fileA->fileSize < fileB->fileSize) ? -1 : 1;
+    }
+    return memcmp(fileA->fullDigest, fileB->fullDigest, sizeof(fileA->fullDigest));
+}
+
+/**
+ * Worker pool job, hashes the first and last DUPE_PARTIAL_SIZE bytes of a
+ * file.  A file small enough for those to cover the whole thing is just
+ * hashed in full, which makes the partial digest its full digest too.
+ *
+ * @param jobArg DupeFile to hash
+ */
+static void partialHashJob(void *jobArg) {
+    DupeFile *dupeFile = (DupeFile*)jobArg;
+    uint8_t readBuffer[DUPE_PARTIAL_SIZE * 2];
+    long long bytesToRead;
+
+    int fileDescriptor = open(dupeFile->filePath, O_RDONLY);
+    if (fileDescriptor < 0) {
+        dupeFile->readError = true;
+        return;
+    }
+
+    if (dupeFile->fileSize <= DUPE_PARTIAL_SIZE * 2) {
+        bytesToRead = dupeFile->fileSize;
+        if (pread(fileDescriptor, readBuffer, bytesToRead, 0) != bytesToRead) {
+            dupeFile->readError = true;
+        }
+    } else {
+        bytesToRead = DUPE_PARTIAL_SIZE * 2;
+        if (pread(fileDescriptor, readBuffer, DUPE_PARTIAL_SIZE, 0) != DUPE_PARTIAL_SIZE ||
+                pread(fileDescriptor, &readBuffer[DUPE_PARTIAL_SIZE], DUPE_PARTIAL_SIZE, 
+                    dupeFile->fileSize - DUPE_PARTIAL_SIZE) != DUPE_PARTIAL_SIZE) {
+            dupeFile->readError = true;
+        }
+    }
+    close(fileDescriptor);
+
+    if (dupeFile->readError) {
+        return;
+    }
+
+    shaProcessBuffer(readBuffer, bytesToRead, dupeFile->partialDigest);
+    if (dupeFile->fileSize <= DUPE_PARTIAL_SIZE * 2) {
+        memcpy(dupeFile->fullDigest, dupeFile->partialDigest, sizeof(dupeFile->fullDigest));
+        dupeFile->fullyHashed = true;
+    }
+}
+
+/**
+ * Worker pool job, hashes a whole file.
+ *
+ * @param jobArg DupeFile to hash
+ */
+static void fullHashJob(void *jobArg) {
+    DupeFile *dupeFile = (DupeFile*)jobArg;
+
+    shaInitRegisters(dupeFile->fullDigest);
+    if (!shaProcessFile(dupeFile->filePath, dupeFile->fileSize, dupeFile->fullDigest)) {
+        dupeFile->readError = true;
+        return;
+    }
+    dupeFile->fullyHashed = true;
+}
+
+/**
+ * Runs the param job on every file in the list on the pool, waits for them
+ * all, then drops any file that couldn't be read from the list.
+ *
+ * @return the number of files left in the list
+ */
+static int runStage(WorkerPool *pool, WorkerJobFunc jobFunc, DupeFile **fileList, 
+        int fileCount) {
+    for (int i = 0; i < fileCount; i++) {
+        workerPoolSubmit(pool, jobFunc, fileList[i]);
+    }
+    workerPoolWait(pool);
+
+    int keptCount = 0;
+    for (int i = 0; i < fileCount; i++) {
+        if (fileList[i]->readError) {
+            fprintf(stderr, "Skipping unreadable file: %s\n", fileList[i]->filePath);
+            continue;
+        }
+        fileList[keptCount] = fileList[i];
+        keptCount++;
+    }
+    return keptCount;
+}
+
+/**
+ * Sorts the param list with the param comparison, and keeps only the files
+ * that compare equal to at least one other file.
+ *
+ * @return the number of files left in the list
+ */
+static int keepCollisions(DupeFile **fileList, int fileCount, 
+        int (*compare)(const void*, const void*)) {
+    qsort(fileList, fileCount, sizeof(DupeFile*), compare);
+
+    int keptCount = 0;
+    for (int i = 0; i < fileCount; i++) {
+        bool matchesPrevious = (i > 0) && (compare(&fileList[i - 1], &fileList[i]) == 0);
+        bool matchesNext = (i < fileCount - 1) && (compare(&fileList[i], &fileList[i + 1]) == 0);
+        if (matchesPrevious || matchesNext) {
+            fileList[keptCount] = fileList[i];
+            keptCount++;
+        }
+    }
+    return keptCount;
+}
+
+/**
+ * Searches the param paths (files or directories, which are searched
+ * recursively) for duplicate files, and prints each group of duplicates as
+ * lines of "digest  path", with a blank line between groups.
+ *
+ * @param searchPaths paths to search
+ * @param searchPathCount number of paths
+ */
+void findDupes(char **searchPaths, int searchPathCount) {
+    for (int i = 0; i < searchPathCount; i++) {
+        if (nftw(searchPaths[i], collectFile, 64, FTW_PHYS) != 0) {
+            printf("Error searching path: %s\nExiting.\n\n", searchPaths[i]);
+            exit(3);
+        }
+    }
+
+    DupeFile **fileList = malloc(sizeof(DupeFile*) * (dupeFileCount + 1));
+    if (fileList == NULL) {
+        printf("Error allocating file list.\nExiting.\n\n");
+        exit(4);
+    }
+    for (int i = 0; i < dupeFileCount; i++) {
+        fileList[i] = &dupeFiles[i];
+    }
+
+    // Drop every file already collected under another path (overlapping
+    // search paths, hard links), keeping the path it was first found by.
+    qsort(fileList, dupeFileCount, sizeof(DupeFile*), compareIdentity);
+    int uniqueFileCount = 0;
+    for (int i = 0; i < dupeFileCount; i++) {
+        if (i > 0 && fileList[i - 1]->fileDevice == fileList[i]->fileDevice &&
+                fileList[i - 1]->fileInode == fileList[i]->fileInode) {
+            continue;
+        }
+        fileList[uniqueFileCount] = fileList[i];
+        uniqueFileCount++;
+        bytesTotal += fileList[i]->fileSize;
+    }
+
+    WorkerPool pool;
+    int threadCount = workerPoolDefaultThreadCount();
+    workerPoolCreate(&pool, threadCount, threadCount * 4);
+
+    // Stage one, group by size
+    int fileCount = keepCollisions(fileList, uniqueFileCount, compareSize);
+
+    // Stage two, hash the ends of each file
+    fileCount = runStage(&pool, partialHashJob, fileList, fileCount);
+    for (int i = 0; i < fileCount; i++) {
+        long long fileSize = fileList[i]->fileSize;
+        bytesRead += (fileSize < DUPE_PARTIAL_SIZE * 2) ? fileSize : DUPE_PARTIAL_SIZE * 2;
+    }
+    fileCount = keepCollisions(fileList, fileCount, comparePartial);
+
+    // Stage three, fully hash whatever still collides.  Small files were
+    // already fully hashed in stage two.
+    int fullHashCount = 0;
+    DupeFile **fullHashList = malloc(sizeof(DupeFile*) * (fileCount + 1));
+    if (fullHashList == NULL) {
+        printf("Error allocating file list.\nExiting.\n\n");
+        exit(4);
+    }
+    for (int i = 0; i < fileCount; i++) {
+        if (!fileList[i]->fullyHashed) {
+            fullHashList[fullHashCount] = fileList[i];
+            fullHashCount++;
+            bytesRead += fileList[i]->fileSize;
+        }
+    }
+    runStage(&pool, fullHashJob, fullHashList, fullHashCount);
+    free(fullHashList);
+
+    workerPoolDestroy(&pool);
+
+    // Anything that failed to read in stage three was never fully hashed,
+    // and is dropped before the final grouping.
+    int keptCount = 0;
+    for (int i = 0; i < fileCount; i++) {
+        if (fileList[i]->fullyHashed) {
+            fileList[keptCount] = fileList[i];
+            keptCount++;
+        }
+    }
+    fileCount = keepCollisions(fileList, keptCount, compareFull);
+
+    int groupCount = 0;
+    for (int i = 0; i < fileCount; i++) {
+        if (i > 0 && compareFull(&fileList[i - 1], &fileList[i]) != 0) {
+            printf("\n");
+        }
+        if (i == 0 || compareFull(&fileList[i - 1], &fileList[i]) != 0) {
+            groupCount++;
+        }
+        for (int j = 0; j < 8; j++) {
+            printf("%08x", fileList[i]->fullDigest[j]);
+        }
+        printf("  %s\n", fileList[i]->filePath);
+    }
+
+    fprintf(stderr, "%d files searched (%lld bytes), %d groups of duplicates found, "
+            "%lld bytes read\n", uniqueFileCount, bytesTotal, groupCount, bytesRead);
+
+    for (int i = 0; i < dupeFileCount; i++) {
+        free(dupeFiles[i].filePath);
+    }
+    free(dupeFiles);
+    free(fileList);
+}
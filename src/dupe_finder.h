@@ -0,0 +1,29 @@
+/**
+ * File:       dupe_finder.h
+ * Author:     Franklyn Dahlberg
+ * Created:    18 October, 2026
+ * Copyright:  2026 (c) Franklyn Dahlberg
+ */
+
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/types.h>
+
+// Number of bytes hashed from each end of a file in the partial hash stage
+#define DUPE_PARTIAL_SIZE (4 * 1024)
+
+// A regular file found while searching for duplicates
+typedef struct _DupeFile {
+    char *filePath;
+    long long fileSize;
+    dev_t fileDevice;            // Device and inode, identifying the file itself
+    ino_t fileInode;
+    uint32_t partialDigest[8];   // Digest of the first and last DUPE_PARTIAL_SIZE bytes
+    uint32_t fullDigest[8];      // Digest of the whole file, valid if fullyHashed
+    bool fullyHashed;
+    bool readError;
+} DupeFile;
+
+// Function declarations
+void findDupes(char **searchPaths, int searchPathCount);
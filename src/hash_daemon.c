@@ -0,0 +1,646 @@
+/**
+ * File:       hash_daemon.c
+ * Author:     Franklyn Dahlberg
+ * Created:    18 October, 2026
+ * Copyright:  2026 (c) Franklyn Dahlberg
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "sha256_summer.h"
+#include "hash_daemon.h"
+#include "worker_pool.h"
+
+/**
+ * A long running hashing daemon, for callers (eg. build systems) that hash
+ * lots of small files, where starting a process per file costs more than
+ * the hashing does.  The daemon listens on a Unix domain socket, each
+ * connection gets a thread that reads batches of requests, and the requests
+ * themselves are hashed on a worker pool shared by every connection.  See
+ * hash_daemon.h for the protocol.
+ */
+
+// Tracks the outstanding requests of one batch on one connection
+typedef struct _DaemonBatch {
+    int jobsRemaining;
+    pthread_mutex_t lock;
+    pthread_cond_t jobsDone;
+} DaemonBatch;
+
+// A single request, waiting to be, or that has been, hashed by a worker
+typedef struct _DaemonJob {
+    uint32_t requestType;
+    char *path;                  // Path to hash, for DAEMON_REQUEST_PATH
+    int fileDescriptor;          // File to hash, for DAEMON_REQUEST_FD
+    DaemonResponse response;
+    DaemonBatch *batch;
+} DaemonJob;
+
+WorkerPool daemonPool;
+char *daemonSocketPath;
+
+// Number of connection threads running, capped at DAEMON_MAX_CONNECTIONS
+int activeConnections;
+pthread_mutex_t connectionLock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t connectionSlotFree = PTHREAD_COND_INITIALIZER;
+
+/**
+ * Gives up a connection slot, letting the accept loop take another
+ * connection.
+ */
+static void releaseConnectionSlot() {
+    pthread_mutex_lock(&connectionLock);
+    activeConnections--;
+    pthread_cond_signal(&connectionSlotFree);
+    pthread_mutex_unlock(&connectionLock);
+}
+
+/**
+ * Signal handler, removes the socket file on the way out.
+ */
+static void daemonSignalHandler(int signalNumber) {
+    unlink(daemonSocketPath);
+    _exit(0);
+}
+
+/**
+ * Hashes the param file descriptor by reading it, rather than mapping it.
+ * If the file shrinks while it is being read, this fails rather than
+ * crashing.
+ *
+ * @param fileDescriptor descriptor of the file to hash
+ * @param fileSize size of the file in bytes
+ * @param registers eight registers, set to the digest on return
+ * @return true if the file was hashed
+ */
+static bool hashDescriptor(int fileDescriptor, long long fileSize, uint32_t *registers) {
+    uint8_t readBuffer[65536];
+    long long readOffset = 0;
+
+    MsgBlock msgBlock;
+    MsgSchedule msgSchedule;
+
+    shaInitRegisters(registers);
+
+    // Read a buffer at a time, processing every full block in it.  Only the
+    // last read can leave a partial block, which becomes the tail.
+    while (true) {
+        long long bytesToRead = fileSize - readOffset;
+        if (bytesToRead > (long long)sizeof(readBuffer)) {
+            bytesToRead = sizeof(readBuffer);
+        }
+
+        long long bytesRead = 0;
+        while (bytesRead < bytesToRead) {
+            ssize_t readResult = pread(fileDescriptor, &readBuffer[bytesRead],
+                    bytesToRead - bytesRead, readOffset + bytesRead);
+            if (readResult <= 0) {
+                return false;
+            }
+            bytesRead += readResult;
+        }
+
+        long long fullBlocks = bytesRead / SHA_BLOCK_SIZE_BYTES;
+        for (long long i = 0; i < fullBlocks; i++) {
+            generateMsgBlock(&readBuffer[i * SHA_BLOCK_SIZE_BYTES], SHA_BLOCK_SIZE_BYTES,
+                    false, fileSize, &msgBlock);
+            generateMsgSchedule(&msgBlock, &msgSchedule);
+            shaProcessMsgSchedule(&msgSchedule, registers);
+        }
+        readOffset += bytesRead;
+
+        if (readOffset == fileSize) {
+            shaProcessTail(&readBuffer[fullBlocks * SHA_BLOCK_SIZE_BYTES],
+                    bytesRead % SHA_BLOCK_SIZE_BYTES, fileSize, registers);
+            return true;
+        }
+    }
+}
+
+/**
+ * Hashes the file the param job refers to, and fills out its response.
+ *
+ * @param job job to hash
+ */
+static void hashDaemonJob(DaemonJob *job) {
+    struct stat fileStat;
+    job->response.status = DAEMON_STATUS_ERROR;
+
+    if (job->requestType == DAEMON_REQUEST_PATH) {
+        if (job->path == NULL || stat(job->path, &fileStat) != 0 || 
+                !S_ISREG(fileStat.st_mode)) {
+            return;
+        }
+        shaInitRegisters(job->response.digest);
+        if (shaProcessFile(job->path, fileStat.st_size, job->response.digest)) {
+            job->response.status = DAEMON_STATUS_OK;
+        }
+        return;
+    }
+
+    if (job->fileDescriptor < 0 || fstat(job->fileDescriptor, &fileStat) != 0 ||
+            !S_ISREG(fileStat.st_mode)) {
+        return;
+    }
+
+    // Only a file that can't shrink or change is safe to map, anything else
+    // could be truncated by the client mid hash, and the daemon would take
+    // a SIGBUS.  Those files are read instead.
+    int fileSeals = fcntl(job->fileDescriptor, F_GET_SEALS);
+    bool fileSealed = (fileSeals >= 0) && (fileSeals & F_SEAL_SHRINK) && 
+        (fileSeals & F_SEAL_WRITE);
+
+    if (!fileSealed) {
+        if (hashDescriptor(job->fileDescriptor, fileStat.st_size, job->response.digest)) {
+            job->response.status = DAEMON_STATUS_OK;
+        }
+        return;
+    }
+
+    // Map the file rather than reading it, so a memfd is hashed in place
+    if (fileStat.st_size == 0) {
+        uint8_t emptyBuffer[1];
+        shaProcessBuffer(emptyBuffer, 0, job->response.digest);
+    } else {
+        void *fileMap = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE,
+                job->fileDescriptor, 0);
+        if (fileMap == MAP_FAILED) {
+            return;
+        }
+        shaProcessBuffer(fileMap, fileStat.st_size, job->response.digest);
+        munmap(fileMap, fileStat.st_size);
+    }
+    job->response.status = DAEMON_STATUS_OK;
+}
+
+/**
+ * Worker pool job, hashes a request and marks it done in its batch.
+ *
+ * @param jobArg DaemonJob to hash
+ */
+static void daemonJobMain(void *jobArg) {
+    DaemonJob *job = (DaemonJob*)jobArg;
+    hashDaemonJob(job);
+    if (job->fileDescriptor >= 0) {
+        close(job->fileDescriptor);
+        job->fileDescriptor = -1;
+    }
+
+    pthread_mutex_lock(&job->batch->lock);
+    job->batch->jobsRemaining--;
+    if (job->batch->jobsRemaining == 0) {
+        pthread_cond_signal(&job->batch->jobsDone);
+    }
+    pthread_mutex_unlock(&job->batch->lock);
+}
+
+/**
+ * Receives a single request message, along with the file descriptor
+ * passed with it, if any.  Every descriptor that arrives with a message is
+ * either handed back or closed, so a client can't leave descriptors open in
+ * the daemon.
+ *
+ * @param connection socket to receive on
+ * @param request filled out with the request, path NUL terminated
+ * @param fileDescriptor set to the passed file descriptor, or -1
+ * @return false if the connection was closed or the message was invalid
+ */
+static bool receiveRequest(int connection, DaemonRequest *request, int *fileDescriptor) {
+    // Room for more descriptors than a valid request carries, so that extra
+    // ones are received (and closed) here rather than counted on the kernel
+    // to drop.
+    char controlBuffer[CMSG_SPACE(sizeof(int) * DAEMON_MAX_RECEIVED_FDS)];
+
+    // Room for the request type and at most PATH_MAX bytes of path.  Anything
+    // longer is truncated, and rejected below.
+    struct iovec requestVector = { request, sizeof(uint32_t) + PATH_MAX };
+    struct msghdr message = { 0 };
+    message.msg_iov = &requestVector;
+    message.msg_iovlen = 1;
+    message.msg_control = controlBuffer;
+    message.msg_controllen = sizeof(controlBuffer);
+
+    *fileDescriptor = -1;
+    ssize_t bytesReceived = recvmsg(connection, &message, MSG_CMSG_CLOEXEC);
+    if (bytesReceived < 0) {
+        return false;
+    }
+
+    // Collect every descriptor passed with the message
+    int receivedFds[DAEMON_MAX_RECEIVED_FDS];
+    int receivedFdCount = 0;
+    for (struct cmsghdr *controlMessage = CMSG_FIRSTHDR(&message); controlMessage != NULL;
+            controlMessage = CMSG_NXTHDR(&message, controlMessage)) {
+        if (controlMessage->cmsg_level != SOL_SOCKET ||
+                controlMessage->cmsg_type != SCM_RIGHTS) {
+            continue;
+        }
+
+        int fdCount = (controlMessage->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        for (int i = 0; i < fdCount && receivedFdCount < DAEMON_MAX_RECEIVED_FDS; i++) {
+            memcpy(&receivedFds[receivedFdCount], CMSG_DATA(controlMessage) + i * sizeof(int),
+                    sizeof(int));
+            receivedFdCount++;
+        }
+    }
+
+    // Only a DAEMON_REQUEST_FD carries a descriptor, and exactly one
+    bool validMessage = (bytesReceived >= (ssize_t)sizeof(uint32_t)) &&
+        !(message.msg_flags & (MSG_TRUNC | MSG_CTRUNC));
+    if (validMessage) {
+        if (request->requestType == DAEMON_REQUEST_FD) {
+            validMessage = (receivedFdCount == 1);
+        } else if (request->requestType == DAEMON_REQUEST_PATH ||
+                request->requestType == DAEMON_REQUEST_END) {
+            validMessage = (receivedFdCount == 0);
+        } else {
+            validMessage = false;
+        }
+    }
+
+    if (!validMessage) {
+        for (int i = 0; i < receivedFdCount; i++) {
+            close(receivedFds[i]);
+        }
+        return false;
+    }
+
+    if (receivedFdCount == 1) {
+        *fileDescriptor = receivedFds[0];
+    }
+    request->path[bytesReceived - sizeof(uint32_t)] = '\0';
+    return true;
+}
+
+/**
+ * Connection thread main.  Reads batches of requests off of the connection,
+ * hands them to the worker pool as they arrive, and sends back the responses
+ * once a batch is done.
+ *
+ * @param connectionArg malloc'd socket file descriptor of the connection
+ */
+static void* connectionThreadMain(void *connectionArg) {
+    int connection = *(int*)connectionArg;
+    free(connectionArg);
+
+    DaemonRequest *request = malloc(sizeof(DaemonRequest));
+    DaemonBatch batch;
+    batch.jobsRemaining = 0;
+    pthread_mutex_init(&batch.lock, NULL);
+    pthread_cond_init(&batch.jobsDone, NULL);
+
+    int jobCapacity = 64;
+    int jobCount = 0;
+    DaemonJob **batchJobs = malloc(sizeof(DaemonJob*) * jobCapacity);
+    bool connectionOpen = (request != NULL && batchJobs != NULL);
+    int fileDescriptor;
+
+    while (connectionOpen) {
+        connectionOpen = receiveRequest(connection, request, &fileDescriptor);
+        if (!connectionOpen) {
+            break;
+        }
+
+        if (request->requestType == DAEMON_REQUEST_END) {
+            pthread_mutex_lock(&batch.lock);
+            while (batch.jobsRemaining > 0) {
+                pthread_cond_wait(&batch.jobsDone, &batch.lock);
+            }
+            pthread_mutex_unlock(&batch.lock);
+
+            for (int i = 0; i < jobCount; i++) {
+                if (connectionOpen && send(connection, &batchJobs[i]->response,
+                            sizeof(DaemonResponse), MSG_NOSIGNAL) < 0) {
+                    connectionOpen = false;
+                }
+                free(batchJobs[i]->path);
+                free(batchJobs[i]);
+            }
+            jobCount = 0;
+            continue;
+        }
+
+        if (jobCount == DAEMON_MAX_BATCH) {
+            if (fileDescriptor >= 0) {
+                close(fileDescriptor);
+            }
+            break;
+        }
+
+        if (jobCount == jobCapacity) {
+            jobCapacity *= 2;
+            DaemonJob **grownJobs = realloc(batchJobs, sizeof(DaemonJob*) * jobCapacity);
+            if (grownJobs == NULL) {
+                if (fileDescriptor >= 0) {
+                    close(fileDescriptor);
+                }
+                break;
+            }
+            batchJobs = grownJobs;
+        }
+
+        DaemonJob *job = calloc(1, sizeof(DaemonJob));
+        if (job == NULL) {
+            if (fileDescriptor >= 0) {
+                close(fileDescriptor);
+            }
+            break;
+        }
+        job->requestType = request->requestType;
+        job->batch = &batch;
+        job->fileDescriptor = -1;
+        if (request->requestType == DAEMON_REQUEST_PATH) {
+            job->path = strdup(request->path);
+        } else {
+            job->fileDescriptor = fileDescriptor;
+        }
+        batchJobs[jobCount] = job;
+        jobCount++;
+
+        pthread_mutex_lock(&batch.lock);
+        batch.jobsRemaining++;
+        pthread_mutex_unlock(&batch.lock);
+        workerPoolSubmit(&daemonPool, daemonJobMain, job);
+    }
+
+    // Jobs from an unfinished batch still point at the batch, so wait for
+    // them before tearing it down.
+    pthread_mutex_lock(&batch.lock);
+    while (batch.jobsRemaining > 0) {
+        pthread_cond_wait(&batch.jobsDone, &batch.lock);
+    }
+    pthread_mutex_unlock(&batch.lock);
+
+    for (int i = 0; i < jobCount; i++) {
+        free(batchJobs[i]->path);
+        free(batchJobs[i]);
+    }
+    free(batchJobs);
+    free(request);
+    pthread_mutex_destroy(&batch.lock);
+    pthread_cond_destroy(&batch.jobsDone);
+    close(connection);
+    releaseConnectionSlot();
+
+    return NULL;
+}
+
+/**
+ * Runs the hashing daemon on the param socket path until it is killed.
+ * Any existing file at the socket path is replaced.
+ *
+ * @param socketPath path of the Unix domain socket to listen on
+ */
+void runDaemon(char *socketPath) {
+    struct sockaddr_un socketAddress = { 0 };
+    socketAddress.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(socketAddress.sun_path)) {
+        printf("Socket path too long: %s\nExiting.\n\n", socketPath);
+        exit(2);
+    }
+    strcpy(socketAddress.sun_path, socketPath);
+
+    // The socket is only accessible to the daemon's own user, otherwise
+    // any local user could have it stat and hash files they can't read.
+    // The umask covers the window between bind and chmod.
+    int listenSocket = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    unlink(socketPath);
+    mode_t previousUmask = umask(0077);
+    int bindResult = (listenSocket < 0) ? -1 : 
+        bind(listenSocket, (struct sockaddr*)&socketAddress, sizeof(socketAddress));
+    umask(previousUmask);
+    if (bindResult != 0 || chmod(socketPath, S_IRUSR | S_IWUSR) != 0 ||
+            listen(listenSocket, SOMAXCONN) != 0) {
+        printf("Error listening on socket: %s\nExiting.\n\n", socketPath);
+        exit(3);
+    }
+
+    daemonSocketPath = socketPath;
+    signal(SIGINT, daemonSignalHandler);
+    signal(SIGTERM, daemonSignalHandler);
+    signal(SIGPIPE, SIG_IGN);
+
+    int threadCount = workerPoolDefaultThreadCount();
+    workerPoolCreate(&daemonPool, threadCount, threadCount * 4);
+
+    struct timeval idleTimeout = { DAEMON_IDLE_TIMEOUT, 0 };
+
+    while (true) {
+        // Wait for a free slot before accepting, leaving any further
+        // connections in the backlog.
+        pthread_mutex_lock(&connectionLock);
+        while (activeConnections >= DAEMON_MAX_CONNECTIONS) {
+            pthread_cond_wait(&connectionSlotFree, &connectionLock);
+        }
+        pthread_mutex_unlock(&connectionLock);
+
+        int connection = accept4(listenSocket, NULL, NULL, SOCK_CLOEXEC);
+        if (connection < 0) {
+            // Out of descriptors or memory, the pending connection stays in
+            // the backlog, so back off rather than spin on it.
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                usleep(100000);
+            }
+            continue;
+        }
+
+        // Only serve clients running as the same user as the daemon
+        struct ucred peerCredentials;
+        socklen_t credentialsLength = sizeof(peerCredentials);
+        if (getsockopt(connection, SOL_SOCKET, SO_PEERCRED, &peerCredentials, 
+                    &credentialsLength) != 0 || peerCredentials.uid != geteuid()) {
+            close(connection);
+            continue;
+        }
+        setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &idleTimeout, sizeof(idleTimeout));
+
+        int *connectionArg = malloc(sizeof(int));
+        pthread_t connectionThread;
+        if (connectionArg == NULL) {
+            close(connection);
+            continue;
+        }
+        *connectionArg = connection;
+
+        pthread_mutex_lock(&connectionLock);
+        activeConnections++;
+        pthread_mutex_unlock(&connectionLock);
+        if (pthread_create(&connectionThread, NULL, connectionThreadMain, connectionArg) != 0) {
+            close(connection);
+            free(connectionArg);
+            releaseConnectionSlot();
+            continue;
+        }
+        pthread_detach(connectionThread);
+    }
+}
+
+/**
+ * Copies stdin into a memfd, so it can be passed to the daemon.  The memfd
+ * is sealed once written, which lets the daemon map it rather than read it.
+ *
+ * @return the memfd, or -1 on failure
+ */
+static int copyStdinToMemfd() {
+    int memoryFile = memfd_create("sha256_summer", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (memoryFile < 0) {
+        return -1;
+    }
+
+    uint8_t readBuffer[65536];
+    ssize_t bytesRead;
+    while ((bytesRead = read(STDIN_FILENO, readBuffer, sizeof(readBuffer))) > 0) {
+        if (write(memoryFile, readBuffer, bytesRead) != bytesRead) {
+            close(memoryFile);
+            return -1;
+        }
+    }
+    if (bytesRead < 0 || fcntl(memoryFile, F_ADD_SEALS, 
+                F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) != 0) {
+        close(memoryFile);
+        return -1;
+    }
+    return memoryFile;
+}
+
+/**
+ * Sends a single request message, with the param file descriptor attached
+ * if it isn't -1.
+ *
+ * @return true if the message was sent
+ */
+static bool sendRequest(int connection, uint32_t requestType, char *path, int fileDescriptor) {
+    DaemonRequest request;
+    size_t pathLength = (path == NULL) ? 0 : strlen(path);
+    if (pathLength > PATH_MAX) {
+        return false;
+    }
+    request.requestType = requestType;
+    if (pathLength > 0) {
+        memcpy(request.path, path, pathLength);
+    }
+
+    struct iovec requestVector = { &request, sizeof(uint32_t) + pathLength };
+    struct msghdr message = { 0 };
+    message.msg_iov = &requestVector;
+    message.msg_iovlen = 1;
+
+    char controlBuffer[CMSG_SPACE(sizeof(int))] = { 0 };
+    if (fileDescriptor >= 0) {
+        message.msg_control = controlBuffer;
+        message.msg_controllen = sizeof(controlBuffer);
+        struct cmsghdr *controlMessage = CMSG_FIRSTHDR(&message);
+        controlMessage->cmsg_level = SOL_SOCKET;
+        controlMessage->cmsg_type = SCM_RIGHTS;
+        controlMessage->cmsg_len = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(controlMessage), &fileDescriptor, sizeof(int));
+    }
+
+    return sendmsg(connection, &message, MSG_NOSIGNAL) >= 0;
+}
+
+/**
+ * Has the daemon on the param socket hash the param paths, and prints the
+ * results as lines of "digest  path".  A path of "-" hashes stdin, which is
+ * handed to the daemon as a memfd.  Exits with an error if any of the paths
+ * couldn't be hashed.
+ *
+ * @param socketPath path of the daemon's Unix domain socket
+ * @param hashPaths paths to hash
+ * @param hashPathCount number of paths
+ */
+void runClient(char *socketPath, char **hashPaths, int hashPathCount) {
+    struct sockaddr_un socketAddress = { 0 };
+    socketAddress.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(socketAddress.sun_path)) {
+        printf("Socket path too long: %s\nExiting.\n\n", socketPath);
+        exit(2);
+    }
+    strcpy(socketAddress.sun_path, socketPath);
+
+    int connection = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (connection < 0 ||
+            connect(connection, (struct sockaddr*)&socketAddress, sizeof(socketAddress)) != 0) {
+        printf("Error connecting to daemon: %s\nExiting.\n\n", socketPath);
+        exit(3);
+    }
+
+    // Paths go out in batches of at most DAEMON_MAX_BATCH, all on the same
+    // connection.  The daemon likely has a different working directory, so
+    // relative paths are resolved here.  Paths that don't resolve are sent
+    // as is, and come back as errors.
+    char resolvedPath[PATH_MAX];
+    bool allHashed = true;
+    DaemonResponse response;
+    for (int batchStart = 0; batchStart < hashPathCount; batchStart += DAEMON_MAX_BATCH) {
+        int batchEnd = batchStart + DAEMON_MAX_BATCH;
+        if (batchEnd > hashPathCount) {
+            batchEnd = hashPathCount;
+        }
+
+        for (int i = batchStart; i < batchEnd; i++) {
+            bool requestSent;
+            if (strcmp(hashPaths[i], "-") == 0) {
+                int memoryFile = copyStdinToMemfd();
+                if (memoryFile < 0) {
+                    printf("Error reading stdin.\nExiting.\n\n");
+                    exit(3);
+                }
+                requestSent = sendRequest(connection, DAEMON_REQUEST_FD, NULL, memoryFile);
+                close(memoryFile);
+            } else if (realpath(hashPaths[i], resolvedPath) != NULL) {
+                requestSent = sendRequest(connection, DAEMON_REQUEST_PATH, resolvedPath, -1);
+            } else {
+                requestSent = sendRequest(connection, DAEMON_REQUEST_PATH, hashPaths[i], -1);
+            }
+
+            if (!requestSent) {
+                printf("Error sending request for: %s\nExiting.\n\n", hashPaths[i]);
+                exit(3);
+            }
+        }
+        if (!sendRequest(connection, DAEMON_REQUEST_END, NULL, -1)) {
+            printf("Error sending request to daemon.\nExiting.\n\n");
+            exit(3);
+        }
+
+        for (int i = batchStart; i < batchEnd; i++) {
+            if (recv(connection, &response, sizeof(response), 0) != sizeof(response)) {
+                printf("Error receiving response from daemon.\nExiting.\n\n");
+                exit(3);
+            }
+
+            if (response.status != DAEMON_STATUS_OK) {
+                printf("Error hashing file: %s\n", hashPaths[i]);
+                allHashed = false;
+                continue;
+            }
+            for (int j = 0; j < 8; j++) {
+                printf("%08x", response.digest[j]);
+            }
+            printf("  %s\n", hashPaths[i]);
+        }
+    }
+    close(connection);
+
+    if (!allHashed) {
+        exit(3);
+    }
+}
@@ -0,0 +1,62 @@
+/**
+ * File:       hash_daemon.h
+ * Author:     Franklyn Dahlberg
+ * Created:    18 October, 2026
+ * Copyright:  2026 (c) Franklyn Dahlberg
+ */
+
+#pragma once
+#include <limits.h>
+#include <stdint.h>
+
+// Protocol, over a SOCK_SEQPACKET Unix domain socket so every message
+// arrives whole:
+//  - The client sends a batch of requests, one message each, followed by a
+//    DAEMON_REQUEST_END message.
+//  - A DAEMON_REQUEST_PATH message carries a path (not NUL terminated) after
+//    the request type.
+//  - A DAEMON_REQUEST_FD message carries no path, instead a single file
+//    descriptor is passed along with it (SCM_RIGHTS).  A memfd sealed
+//    against shrinking and writing is mapped and hashed in place, so it
+//    makes for a zero copy buffer.  Any other descriptor is read, since a
+//    mapped file shrinking underneath the daemon would crash it.
+//  - Once the batch ends, the daemon sends back one DaemonResponse message
+//    per request, in request order.
+//  - The connection may then send another batch, or close.
+//  - A batch may hold at most DAEMON_MAX_BATCH requests.  The daemon closes
+//    the connection on a larger batch, an unknown request type, a message
+//    too long for a path of PATH_MAX bytes, or a message carrying the wrong
+//    number of descriptors (one for DAEMON_REQUEST_FD, none otherwise).
+#define DAEMON_REQUEST_END  0
+#define DAEMON_REQUEST_PATH 1
+#define DAEMON_REQUEST_FD   2
+
+#define DAEMON_MAX_BATCH    1024
+
+// Connections served at once.  Further connections wait in the listen
+// backlog until one closes.  A connection that sends nothing for
+// DAEMON_IDLE_TIMEOUT seconds is closed, so idle clients can't hold on to
+// every slot.
+#define DAEMON_MAX_CONNECTIONS  64
+#define DAEMON_IDLE_TIMEOUT     30
+
+// Descriptors the daemon makes room for in a single message.  Only one is
+// ever valid, the rest are there to be received and closed.
+#define DAEMON_MAX_RECEIVED_FDS 16
+
+#define DAEMON_STATUS_OK    0
+#define DAEMON_STATUS_ERROR 1
+
+typedef struct _DaemonRequest {
+    uint32_t requestType;
+    char path[PATH_MAX + 1];     // Space for the NUL added on receipt
+} DaemonRequest;
+
+typedef struct _DaemonResponse {
+    uint32_t status;
+    uint32_t digest[8];
+} DaemonResponse;
+
+// Function declarations
+void runDaemon(char *socketPath);
+void runClient(char *socketPath, char **hashPaths, int hashPathCount);
@@ -5,17 +5,30 @@
  * Copyright:  2025 (c) Franklyn Dahlberg
  */
 
+#define _GNU_SOURCE
+
+#include <errno.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
 
 #include "sha256_summer.h"
+#include "chunker.h"
+#include "dupe_finder.h"
+#include "hash_daemon.h"
 
 const int SHA_BLOCK_SIZE_BYTES = 64;
 
 FILE* filePointer;
 
+// The message schedule of an all zero block.  Both lowercase sigma functions
+// map zero to zero, so every generated word is zero as well and the schedule
+// is simply all zeros.  Used for the blocks in the holes of sparse files.
+MsgSchedule zeroBlockSchedule = { { 0 } };
+
 long fileSize;               // The length of the file in bytes
 long fileWordSize;           // The length of the file in 32 bit words 
 int bitsInLastBlock;         // The number of bits in the last block.
@@ -37,21 +50,37 @@ uint32_t workingRegisters[8] = {squareConst[0], squareConst[1], squareConst[2],
                                 squareConst[3], squareConst[4], squareConst[5],
                                 squareConst[6], squareConst[7]};
 
-// Temp registers, used to temporarily hold the values of the working registers
-// during processing.
-uint32_t tempRegisters[8];
-
-// Temporary values, used during compression.
-uint32_t T1;
-uint32_t T2;
-
 /**
  * Program main
  */
 void main(int argc, char *argv[]) {
-    checkProgramArgValidity(argc);
+    checkProgramArgValidity(argc, argv);
+
+    if (strcmp(argv[1], "--chunk") == 0) {
+        chunkFile(argv[2], argv[3]);
+        return;
+    }
+
+    if (strcmp(argv[1], "--find-dupes") == 0) {
+        findDupes(&argv[2], argc - 2);
+        return;
+    }
+
+    if (strcmp(argv[1], "--daemon") == 0) {
+        runDaemon(argv[2]);
+        return;
+    }
+
+    if (strcmp(argv[1], "--client") == 0) {
+        runClient(argv[2], &argv[3], argc - 3);
+        return;
+    }
+
     analyzeFile(filePointer, argv[1]);
-    shaProcessFile(filePointer, argv[1]);
+    if (!shaProcessFile(argv[1], fileSize, workingRegisters)) {
+        printf("Error opening file: %s\nExiting.\n\n", argv[1]);
+        exit(3);
+    }
     printWorkingRegisters();
 }
 
@@ -117,141 +146,179 @@ void analyzeFile(FILE* filePointer, char* filePath) {
 }
 
 /**
- * Performs the SHA-256 algorithm on the param file.
+ * Finds the data region of the param file at or after the param offset,
+ * using SEEK_DATA and SEEK_HOLE.  Everything from the offset up to the
+ * start of the region is a hole, which reads back as zeros.  If the
+ * filesystem doesn't report holes, the whole rest of the file is treated as
+ * data.  This moves the file descriptor offset, so the caller must re-seek
+ * any stream on it.
+ *
+ * @param fileDescriptor descriptor of the open file
+ * @param offset offset to search from
+ * @param messageSize size of the file in bytes
+ * @param dataStart set to the start of the data region
+ * @param dataEnd set to the end of the data region
+ */
+static void findDataRegion(int fileDescriptor, off_t offset, long long messageSize,
+        off_t *dataStart, off_t *dataEnd) {
+    *dataStart = lseek(fileDescriptor, offset, SEEK_DATA);
+    if (*dataStart < 0) {
+        if (errno == ENXIO) {
+            // No more data, the rest of the file is a hole
+            *dataStart = messageSize;
+            *dataEnd = messageSize;
+        } else {
+            // Holes aren't supported here, read everything
+            *dataStart = offset;
+            *dataEnd = messageSize;
+        }
+        return;
+    }
+
+    *dataEnd = lseek(fileDescriptor, *dataStart, SEEK_HOLE);
+    if (*dataEnd < 0 || *dataEnd > messageSize) {
+        *dataEnd = messageSize;
+    }
+    if (*dataStart > messageSize) {
+        *dataStart = messageSize;
+    }
+}
+
+/**
+ * Performs the SHA-256 algorithm on the param file.  The registers are
+ * expected to already hold the initial hash value, and hold the digest
+ * on return.
+ *
+ * Sparse files (VM images, database files, etc.) are handled without reading
+ * their holes.  Every block that lies entirely in a hole is all zeros, and
+ * the message schedule of an all zero block is always the same, so those
+ * blocks skip both the read and schedule generation.  The digest is the same
+ * as if every byte had been read.
  *
- * @param filePointer file pointer to the file to process
  * @param filePath path to the file to process
+ * @param messageSize size of the file in bytes
+ * @param registers eight working registers to update
+ * @return true if the file was hashed, false if it could not be read
  */
-void shaProcessFile(FILE* filePointer, char* filePath) {
-    filePointer = fopen(filePath, "rb");
-    long long bytesRemaining = fileSize;
-    int bytesRead = 0;
+bool shaProcessFile(char* filePath, long long messageSize, uint32_t *registers) {
+    FILE* filePointer = fopen(filePath, "rb");
+    if (filePointer == NULL) {
+        return false;
+    }
 
-    bool eofReached = false;
-    bool fileStopByteAdded = false;
-    bool fileSizeEncodingAdded = false;
-    bool lastBlock = false;
+    int fileDescriptor = fileno(filePointer);
+    off_t dataStart = 0;         // Start of the current data region
+    off_t dataEnd = 0;           // End of the current data region
+    long long blockOffset = 0;   // Offset of the next block to process
 
     // Buffer for reading the file in
-    uint8_t fileReadBuffer[512];
+    uint8_t fileReadBuffer[64];
 
     MsgBlock msgBlock;
     MsgSchedule msgSchedule;
 
-    // Read the file in block by block, processing each block as it is read
-    // Six possible outcomes in the read phase:
-    //  1. SHA_BLOCK_SIZE can be read without reaching EOF: in which case just read the bytes
-    //     in and process them.
-    //  2. File ends before SHA_BLOCK_SIZE, but 'file_end + 1 byte (file stop indicator) + 8 bytes
-    //     (file size encoding)' is less than SHA_BLOCK_SIZE: in which case read the file in, append
-    //     0x80 to the byte immediately following EOF, and process it, flag that this is the last block.
-    //  3. File ends at SHA_BLOCK_SIZE EXACTLY: in which case read the file in and process it.  We'll
-    //     need one more block where the first byte is a file stop indicator.
-    //  4. File ends before SHA_BLOCK_SIZE, but 'file_end + 1 byte (file stop indicator) + 8 bytes
-    //     (file size encoding) is greater than SHA_BLOCK_SIZE: in which case read the file in, append
-    //     0x80 to the byte immediately following EOF, and process it.  We'll need one more block with
-    //     file size encoding only.
-    //  5. EOF already reached, but file stop byte has not been appended: generate a block with byte 0
-    //     being the file stop byte (0x80).  This occured because case 3 was hit previously.  Flag that
-    //     this is the last block.
-    //  6. EOF already reached, file stop byte has already been appended: generate a block of all 0x00,
-    //     and flag that this is the last block.  This occured because case 4 was hit previously.
-    //     This block is only to include file size encoding.  Flag that this is the last block.
-    do {
-        bytesRead = 0;
-
-        if (bytesRemaining > SHA_BLOCK_SIZE_BYTES) {
-            // Cases one, just read the file in
-            //printf("Here in case 1\n");
-            for (int i = 0; i < SHA_BLOCK_SIZE_BYTES; i++) {
-                fread(&fileReadBuffer[i], sizeof(uint8_t), 1, filePointer);
-                bytesRead++;
-                bytesRemaining--;
-            }
-        }else if (!eofReached && ((SHA_BLOCK_SIZE_BYTES - bytesRemaining) > 8)) {
-            // Cases two, read the file in, apply the stop bit as needed
-            //printf("Here in case 2\n");
-            for (int i = 0; i < SHA_BLOCK_SIZE_BYTES; i++) {
-                if (bytesRemaining > 0) {
-                    fread(&fileReadBuffer[i], sizeof(uint8_t), 1, filePointer);
-                    bytesRead++;
-                    bytesRemaining--;
-                }else if (!fileStopByteAdded) {
-                    eofReached = true;
-                    fileReadBuffer[i] = 0x80;
-                    fileStopByteAdded = true;
-                    bytesRead++;
-                    bytesRemaining--;
-                }else {
-                    fileReadBuffer[i] = 0x00;
-                    bytesRemaining--;
-                }
-            }
-            fileSizeEncodingAdded = true;
-            lastBlock = true;
-        }else if (!eofReached && ((SHA_BLOCK_SIZE_BYTES - bytesRemaining) == 0)) {
-            // Case three, just read in the file, make a block, and process it
-            //printf("Here in case 3\n");
-            for (int i = 0; i < SHA_BLOCK_SIZE_BYTES; i++) {
-                fread(&fileReadBuffer[i], sizeof(uint8_t), 1, filePointer);
-                bytesRead++;
-                bytesRemaining--;
-            }
-            eofReached = true;
-        }else if (!eofReached && ((SHA_BLOCK_SIZE_BYTES - bytesRemaining) < 8)) {
-            // Case four, we have enough room for the file stop indicator, but not
-            // enough room for file size encoding.  Read the file, append the file
-            // stop indicator, but fileSizeEncoding will be handled in the next block.
-            //printf("Here in case 4\n");
-            for (int i = 0; i < SHA_BLOCK_SIZE_BYTES; i++) {
-                if (bytesRemaining > 0) {
-                    fread(&fileReadBuffer[i], sizeof(uint8_t), 1, filePointer);
-                    bytesRead++;
-                    bytesRemaining--;
-                }else if (!fileStopByteAdded) {
-                    eofReached = true;
-                    fileReadBuffer[i] = 0x80;
-                    fileStopByteAdded = true;
-                    bytesRead++;
-                    bytesRemaining--;
-                }else {
-                    fileReadBuffer[i] = 0x00;
-                    bytesRemaining--;
-                }
-            }
-            eofReached = true;
-        }else if (eofReached && !fileStopByteAdded) {
-            // Case five, we've previously hit case three, add the file stop byte to
-            // the first byte of the block, and read in zeros for everything else.
-            //printf("Here in case 5\n");
-            fileReadBuffer[0] = 0x80;
-            bytesRemaining--;
-            fileStopByteAdded = true;
-            for (int i = 1; i < SHA_BLOCK_SIZE_BYTES; i++) {
-                fileReadBuffer[i] = 0x00;
-                bytesRemaining--;
-            }
-            fileSizeEncodingAdded = true;
-            lastBlock = true;
-        }else if (eofReached && fileStopByteAdded) {
-            // Case six, we've previously hit case four, we just need a block of
-            // all zeros at this point
-            //printf("Here in case 6\n");
-            for (int i = 0; i < SHA_BLOCK_SIZE_BYTES; i++) {
-                fileReadBuffer[i] = 0x00;
-                bytesRemaining--;
+    // Every full block of the file is processed as is.  Blocks in a hole go
+    // straight to compression with the all zero schedule.
+    while (blockOffset + SHA_BLOCK_SIZE_BYTES <= messageSize) {
+        if (blockOffset >= dataEnd) {
+            findDataRegion(fileDescriptor, blockOffset, messageSize, &dataStart, &dataEnd);
+            fseeko(filePointer, blockOffset, SEEK_SET);
+        }
+
+        if (blockOffset + SHA_BLOCK_SIZE_BYTES <= dataStart) {
+            long long zeroBlocks = (dataStart - blockOffset) / SHA_BLOCK_SIZE_BYTES;
+            for (long long i = 0; i < zeroBlocks; i++) {
+                shaProcessMsgSchedule(&zeroBlockSchedule, registers);
             }
-            fileSizeEncodingAdded = true;
-            lastBlock = true;
+            blockOffset += zeroBlocks * SHA_BLOCK_SIZE_BYTES;
+            fseeko(filePointer, blockOffset, SEEK_SET);
+            continue;
         }
 
-        generateMsgBlock(fileReadBuffer, bytesRead, lastBlock, &msgBlock);
+        if (fread(fileReadBuffer, 1, SHA_BLOCK_SIZE_BYTES, filePointer) != (size_t)SHA_BLOCK_SIZE_BYTES) {
+            fclose(filePointer);
+            return false;
+        }
+        generateMsgBlock(fileReadBuffer, SHA_BLOCK_SIZE_BYTES, false, messageSize, &msgBlock);
         generateMsgSchedule(&msgBlock, &msgSchedule);
-        shaProcessMsgSchedule(&msgSchedule);
+        shaProcessMsgSchedule(&msgSchedule, registers);
+        blockOffset += SHA_BLOCK_SIZE_BYTES;
+    }
 
-    }while (!eofReached && !fileStopByteAdded && !fileSizeEncodingAdded);
+    // Whatever is left is less than a block, and gets padded out
+    size_t tailLength = messageSize - blockOffset;
+    if (fread(fileReadBuffer, 1, tailLength, filePointer) != tailLength) {
+        fclose(filePointer);
+        return false;
+    }
+    shaProcessTail(fileReadBuffer, tailLength, messageSize, registers);
 
     fclose(filePointer);
+    return true;
+}
+
+/**
+ * Performs the SHA-256 algorithm on an in memory buffer.  Unlike
+ * shaProcessFile, this keeps no global state, so it is safe to call from
+ * several threads at once as long as each uses its own registers.
+ *
+ * @param buffer bytes to hash
+ * @param length length of the buffer in bytes
+ * @param registers eight registers, set to the digest on return
+ */
+void shaProcessBuffer(uint8_t* buffer, uint64_t length, uint32_t *registers) {
+    MsgBlock msgBlock;
+    MsgSchedule msgSchedule;
+
+    shaInitRegisters(registers);
+
+    // Every full block can be used straight out of the buffer
+    uint64_t fullBlocks = length / SHA_BLOCK_SIZE_BYTES;
+    for (uint64_t i = 0; i < fullBlocks; i++) {
+        generateMsgBlock(&buffer[i * SHA_BLOCK_SIZE_BYTES], SHA_BLOCK_SIZE_BYTES, 
+                false, length, &msgBlock);
+        generateMsgSchedule(&msgBlock, &msgSchedule);
+        shaProcessMsgSchedule(&msgSchedule, registers);
+    }
+
+    shaProcessTail(&buffer[fullBlocks * SHA_BLOCK_SIZE_BYTES], length % SHA_BLOCK_SIZE_BYTES,
+            length, registers);
+}
+
+/**
+ * Processes the last partial block (which may be empty) of a message,
+ * along with the padding and size encoding that follow it.
+ *
+ * The file stop byte (0x80) is appended to the tail.  If that leaves room
+ * for the size encoding (last 8 bytes of the block), the tail is the last
+ * block.  Otherwise the tail goes out as a regular block, and the size
+ * encoding gets a block of its own.
+ *
+ * @param tail bytes of the message after the last full block
+ * @param tailLength number of bytes in the tail, less than a block
+ * @param messageSize length of the whole message in bytes
+ * @param registers eight working registers to update
+ */
+void shaProcessTail(uint8_t* tail, int tailLength, uint64_t messageSize, 
+        uint32_t *registers) {
+    MsgBlock msgBlock;
+    MsgSchedule msgSchedule;
+
+    uint8_t tailBuffer[64] = { 0 };
+    memcpy(tailBuffer, tail, tailLength);
+    tailBuffer[tailLength] = 0x80;
+    tailLength++;
+
+    if (tailLength > SHA_BLOCK_SIZE_BYTES - 8) {
+        generateMsgBlock(tailBuffer, tailLength, false, messageSize, &msgBlock);
+        generateMsgSchedule(&msgBlock, &msgSchedule);
+        shaProcessMsgSchedule(&msgSchedule, registers);
+        tailLength = 0;
+    }
+
+    generateMsgBlock(tailBuffer, tailLength, true, messageSize, &msgBlock);
+    generateMsgSchedule(&msgBlock, &msgSchedule);
+    shaProcessMsgSchedule(&msgSchedule, registers);
 }
 
 /**
@@ -262,10 +329,11 @@ void shaProcessFile(FILE* filePointer, char* filePath) {
  * @param byteBuffer Byte buffer to use
  * @param bufferLength length of the param byte buffer in bytes
  * @param lastBlock true if this is the last block of the message, otherwise false
+ * @param messageSize length of the whole message in bytes
  * @param MsgBlock pointer to fill out for result
  */
 void generateMsgBlock(uint8_t* byteBuffer, int bufferLength, bool lastBlock, 
-        MsgBlock *msgBlock) {
+        uint64_t messageSize, MsgBlock *msgBlock) {
 
     // We know we're setting all registers in the block every time, so no need to
     // initialize anything to 0.
@@ -294,7 +362,7 @@ void generateMsgBlock(uint8_t* byteBuffer, int bufferLength, bool lastBlock,
         msgBlock->blockWords[14] = 0x00;
         msgBlock->blockWords[15] = 0x00;
 
-        uint64_t fileLengthEnc = (uint64_t)fileSize * 8;
+        uint64_t fileLengthEnc = messageSize * 8;
         msgBlock->blockWords[14] = (fileLengthEnc >> 32) | msgBlock->blockWords[14];
         msgBlock->blockWords[15] = fileLengthEnc | msgBlock->blockWords[15];
     } else {
@@ -336,37 +404,57 @@ void generateMsgSchedule(MsgBlock *msgBlock, MsgSchedule *msgSchedule) {
 
 /**
  * Performs the SHA-256 algorithm on the param message schedule, updating the 
- * working registers.
+ * param registers.
  *
  * @param MsgSchedule pointer of data to execute on
+ * @param registers eight working registers to update
  */
-void shaProcessMsgSchedule(MsgSchedule *msgSchedule) {
+void shaProcessMsgSchedule(MsgSchedule *msgSchedule, uint32_t *registers) {
+    // Temp registers, used to hold the values of the working registers
+    // from before compression.
+    uint32_t tempRegisters[8];
+
+    // Temporary values, used during compression.
+    uint32_t T1;
+    uint32_t T2;
+
     // Copy all the working registers to the temp registers, to add that
     // data back in after performing compression.
     for (int i = 0 ; i < 8; i++) {
-        tempRegisters[i] = workingRegisters[i];
+        tempRegisters[i] = registers[i];
     }
 
     for (int i = 0; i < 64; i++) {
-        T1 = upSig1(workingRegisters[4]) + 
-             choice(workingRegisters[4], workingRegisters[5], workingRegisters[6]) + 
-             workingRegisters[7] + cubicConst[i] + msgSchedule->scheduleWords[i];
-        T2 = upSig0(workingRegisters[0]) + 
-             majority(workingRegisters[0], workingRegisters[1], workingRegisters[2]);
+        T1 = upSig1(registers[4]) + 
+             choice(registers[4], registers[5], registers[6]) + 
+             registers[7] + cubicConst[i] + msgSchedule->scheduleWords[i];
+        T2 = upSig0(registers[0]) + 
+             majority(registers[0], registers[1], registers[2]);
 
         // Shift all registers to the right one place (h registers falls off)
         for (int j = 7; j > 0; j--) {
-            workingRegisters[j] = workingRegisters[j - 1];
+            registers[j] = registers[j - 1];
         }
 
-        workingRegisters[0] = T1 + T2;
-        workingRegisters[4] = workingRegisters[4] + T1;
+        registers[0] = T1 + T2;
+        registers[4] = registers[4] + T1;
     }
 
     // Add the temp registers (registers before compression) back into 
     // the working registers
     for(int i = 0; i < 8; i++) {
-        workingRegisters[i] = workingRegisters[i] + tempRegisters[i];
+        registers[i] = registers[i] + tempRegisters[i];
+    }
+}
+
+/**
+ * Sets the param registers to the initial hash value (the square constants).
+ *
+ * @param registers eight registers to initialize
+ */
+void shaInitRegisters(uint32_t *registers) {
+    for (int i = 0; i < 8; i++) {
+        registers[i] = squareConst[i];
     }
 }
 
@@ -374,21 +462,50 @@ void shaProcessMsgSchedule(MsgSchedule *msgSchedule) {
  * Prints the working registers in hex form
  */
 void printWorkingRegisters() {
+    printDigest(workingRegisters);
+}
+
+/**
+ * Prints the param registers in hex form
+ *
+ * @param registers eight registers holding a digest
+ */
+void printDigest(uint32_t *registers) {
     for (int i = 0; i < 8; i++) {
-        printf("%08x", workingRegisters[i]);
+        printf("%08x", registers[i]);
     }
     printf("\n");
 }
 
 /**
  * Checks the arguments provided to the program runtime and verifies they
- * are valid.  If they are invalid, exit the program.
+ * are valid for the requested mode.  If they are invalid, exit the program.
  */
-void checkProgramArgValidity(int argc) {
-    if (argc != 2) {
+void checkProgramArgValidity(int argc, char *argv[]) {
+    if (argc == 4 && strcmp(argv[1], "--chunk") == 0) {
+        return;
+    }
+    if (argc >= 3 && strcmp(argv[1], "--find-dupes") == 0) {
+        return;
+    }
+    if (argc == 3 && strcmp(argv[1], "--daemon") == 0) {
+        return;
+    }
+    if (argc >= 4 && strcmp(argv[1], "--client") == 0) {
+        return;
+    }
+
+    if (argc != 2 || strncmp(argv[1], "--", 2) == 0) {
         printf("Pass the absolute or relative path to the file to hash as" 
                 " an argument to this program.\n");
         printf("\tEg. ./sha256_summer /path/to/file\n");
+        printf("To write a content defined chunk manifest of a file instead:\n");
+        printf("\tEg. ./sha256_summer --chunk /path/to/file /path/to/manifest\n");
+        printf("To find duplicate files under one or more paths:\n");
+        printf("\tEg. ./sha256_summer --find-dupes /path/to/dir [/path/to/other]\n");
+        printf("To run a hashing daemon, and have it hash files (- for stdin):\n");
+        printf("\tEg. ./sha256_summer --daemon /path/to/socket\n");
+        printf("\tEg. ./sha256_summer --client /path/to/socket /path/to/file [-]\n");
         printf("Exiting.\n\n");
         exit(2);
     }
@@ -25,15 +25,20 @@ typedef struct _MsgSchedule {
 } MsgSchedule;
 
 // Function declarations
-void checkProgramArgValidity(int argc);
+void checkProgramArgValidity(int argc, char *argv[]);
 bool checkEndianness();
 void analyzeFile(FILE* filePointer, char* filePath);
 void generateMsgSchedule(MsgBlock *msgBlock, MsgSchedule *msgSchedule);
 void generateMsgBlock(uint8_t* byteBuffer, int bufferLength, bool lastBlock, 
-                        MsgBlock *msgBlock);
-void shaProcessFile(FILE* filePointer, char* filePath);
-void shaProcessMsgSchedule(MsgSchedule *msgSchedule);
+                        uint64_t messageSize, MsgBlock *msgBlock);
+bool shaProcessFile(char* filePath, long long messageSize, uint32_t *registers);
+void shaProcessBuffer(uint8_t* buffer, uint64_t length, uint32_t *registers);
+void shaProcessTail(uint8_t* tail, int tailLength, uint64_t messageSize, 
+                        uint32_t *registers);
+void shaProcessMsgSchedule(MsgSchedule *msgSchedule, uint32_t *registers);
+void shaInitRegisters(uint32_t *registers);
 void printWorkingRegisters();
+void printDigest(uint32_t *registers);
 
 // Common SHA functions
 uint32_t lowSig0(uint32_t x);
@@ -44,12 +49,16 @@ uint32_t choice(uint32_t x, uint32_t y, uint32_t z);
 uint32_t majority(uint32_t x, uint32_t y, uint32_t z);
 
 //Constants
+// Size of a message block in bytes, defined in sha256_summer.c
+extern const int SHA_BLOCK_SIZE_BYTES;
+
+// These are static so the header can be shared between translation units.
 // Square root constants
-const uint32_t squareConst[] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+static const uint32_t squareConst[] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
                                  0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
 
 // Cubic root constants
-const uint32_t cubicConst[] = { 0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+static const uint32_t cubicConst[] = { 0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
                                 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
                                 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
                                 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
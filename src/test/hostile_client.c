@@ -0,0 +1,199 @@
+/**
+ * File:       hostile_client.c
+ * Author:     Franklyn Dahlberg
+ * Created:    18 October, 2026
+ * Copyright:  2026 (c) Franklyn Dahlberg
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../hash_daemon.h"
+
+/**
+ * A misbehaving client for test_daemon.sh.  Each scenario breaks the daemon
+ * protocol in one way, and checks that the daemon responds the way it
+ * should (usually by closing the connection).  Exits with 0 if it did,
+ * 1 otherwise.  A daemon that neither responds nor closes the connection
+ * within RESPONSE_TIMEOUT seconds fails the scenario rather than hanging
+ * the test.
+ *
+ * Scenarios:
+ *  truncate     - unsealed memfd, truncated while the daemon hashes it
+ *  unsealed     - stdin in an unsealed memfd, prints the digest
+ *  overlong     - path longer than PATH_MAX
+ *  unknown-type - request type the daemon doesn't know
+ *  over-cap     - batch of more than DAEMON_MAX_BATCH requests
+ *  extra-fds    - DAEMON_REQUEST_FD carrying two descriptors
+ *  missing-fd   - DAEMON_REQUEST_FD carrying no descriptor
+ *  fd-on-path   - DAEMON_REQUEST_PATH carrying a descriptor
+ *  fd-on-end    - DAEMON_REQUEST_END carrying a descriptor
+ */
+
+#define RESPONSE_TIMEOUT 5
+
+// Function declarations
+int connectToDaemon(char *socketPath);
+bool sendMessage(int connection, uint32_t requestType, char *path, int *fds, int fdCount);
+bool connectionClosed(int connection);
+bool receiveResponse(int connection, DaemonResponse *response);
+
+/**
+ * Program main
+ */
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        printf("Pass the scenario and the daemon socket path as arguments"
+                " to this program.\n");
+        printf("\tEg. ./hostile_client extra-fds /path/to/socket\n");
+        printf("Exiting.\n\n");
+        exit(2);
+    }
+
+    char *scenario = argv[1];
+    int connection = connectToDaemon(argv[2]);
+    int fds[2] = { open("/dev/null", O_RDONLY), open("/dev/null", O_RDONLY) };
+    DaemonResponse response;
+
+    if (strcmp(scenario, "truncate") == 0) {
+        int memoryFile = memfd_create("hostile_client", 0);
+        ftruncate(memoryFile, 64 * 1024 * 1024);
+        sendMessage(connection, DAEMON_REQUEST_FD, NULL, &memoryFile, 1);
+        sendMessage(connection, DAEMON_REQUEST_END, NULL, NULL, 0);
+        ftruncate(memoryFile, 0);
+        // Any response at all means the daemon survived
+        return receiveResponse(connection, &response) ? 0 : 1;
+    }
+
+    if (strcmp(scenario, "unsealed") == 0) {
+        int memoryFile = memfd_create("hostile_client", 0);
+        uint8_t readBuffer[65536];
+        ssize_t bytesRead;
+        while ((bytesRead = read(STDIN_FILENO, readBuffer, sizeof(readBuffer))) > 0) {
+            write(memoryFile, readBuffer, bytesRead);
+        }
+        sendMessage(connection, DAEMON_REQUEST_FD, NULL, &memoryFile, 1);
+        sendMessage(connection, DAEMON_REQUEST_END, NULL, NULL, 0);
+        if (!receiveResponse(connection, &response) || response.status != DAEMON_STATUS_OK) {
+            return 1;
+        }
+        for (int i = 0; i < 8; i++) {
+            printf("%08x", response.digest[i]);
+        }
+        printf("\n");
+        return 0;
+    }
+
+    if (strcmp(scenario, "overlong") == 0) {
+        char *longPath = malloc(PATH_MAX + 2);
+        memset(longPath, 'a', PATH_MAX + 1);
+        longPath[PATH_MAX + 1] = '\0';
+        sendMessage(connection, DAEMON_REQUEST_PATH, longPath, NULL, 0);
+    } else if (strcmp(scenario, "unknown-type") == 0) {
+        sendMessage(connection, 7, "/etc/hostname", NULL, 0);
+    } else if (strcmp(scenario, "over-cap") == 0) {
+        for (int i = 0; i <= DAEMON_MAX_BATCH; i++) {
+            sendMessage(connection, DAEMON_REQUEST_PATH, "/dev/null", NULL, 0);
+        }
+    } else if (strcmp(scenario, "extra-fds") == 0) {
+        sendMessage(connection, DAEMON_REQUEST_FD, NULL, fds, 2);
+    } else if (strcmp(scenario, "missing-fd") == 0) {
+        sendMessage(connection, DAEMON_REQUEST_FD, NULL, NULL, 0);
+    } else if (strcmp(scenario, "fd-on-path") == 0) {
+        sendMessage(connection, DAEMON_REQUEST_PATH, "/dev/null", fds, 1);
+    } else if (strcmp(scenario, "fd-on-end") == 0) {
+        sendMessage(connection, DAEMON_REQUEST_END, NULL, fds, 1);
+    } else {
+        printf("Unknown scenario: %s\nExiting.\n\n", scenario);
+        exit(2);
+    }
+
+    sendMessage(connection, DAEMON_REQUEST_END, NULL, NULL, 0);
+    return connectionClosed(connection) ? 0 : 1;
+}
+
+/**
+ * Connects to the daemon on the param socket, exits on failure.
+ */
+int connectToDaemon(char *socketPath) {
+    struct sockaddr_un socketAddress = { 0 };
+    socketAddress.sun_family = AF_UNIX;
+    strncpy(socketAddress.sun_path, socketPath, sizeof(socketAddress.sun_path) - 1);
+
+    int connection = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    if (connection < 0 ||
+            connect(connection, (struct sockaddr*)&socketAddress, sizeof(socketAddress)) != 0) {
+        printf("Error connecting to daemon: %s\nExiting.\n\n", socketPath);
+        exit(3);
+    }
+
+    struct timeval responseTimeout = { RESPONSE_TIMEOUT, 0 };
+    setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &responseTimeout, sizeof(responseTimeout));
+    return connection;
+}
+
+/**
+ * Sends a request message with any number of descriptors attached.  Send
+ * failures are expected once the daemon has closed the connection.
+ *
+ * @return true if the message was sent
+ */
+bool sendMessage(int connection, uint32_t requestType, char *path, int *fds, int fdCount) {
+    size_t pathLength = (path == NULL) ? 0 : strlen(path);
+    uint8_t *messageBuffer = malloc(sizeof(uint32_t) + pathLength);
+    memcpy(messageBuffer, &requestType, sizeof(uint32_t));
+    if (pathLength > 0) {
+        memcpy(&messageBuffer[sizeof(uint32_t)], path, pathLength);
+    }
+
+    struct iovec requestVector = { messageBuffer, sizeof(uint32_t) + pathLength };
+    struct msghdr message = { 0 };
+    message.msg_iov = &requestVector;
+    message.msg_iovlen = 1;
+
+    char controlBuffer[CMSG_SPACE(sizeof(int) * 2)] = { 0 };
+    if (fdCount > 0) {
+        message.msg_control = controlBuffer;
+        message.msg_controllen = CMSG_SPACE(sizeof(int) * fdCount);
+        struct cmsghdr *controlMessage = CMSG_FIRSTHDR(&message);
+        controlMessage->cmsg_level = SOL_SOCKET;
+        controlMessage->cmsg_type = SCM_RIGHTS;
+        controlMessage->cmsg_len = CMSG_LEN(sizeof(int) * fdCount);
+        memcpy(CMSG_DATA(controlMessage), fds, sizeof(int) * fdCount);
+    }
+
+    bool messageSent = sendmsg(connection, &message, MSG_NOSIGNAL) >= 0;
+    free(messageBuffer);
+    return messageSent;
+}
+
+/**
+ * Returns true if the daemon closed the param connection rather than
+ * responding on it, false if it responded or timed out.
+ */
+bool connectionClosed(int connection) {
+    DaemonResponse response;
+    ssize_t bytesReceived = recv(connection, &response, sizeof(response), 0);
+    return bytesReceived == 0 || (bytesReceived < 0 && errno == ECONNRESET);
+}
+
+/**
+ * Receives a single response.
+ *
+ * @return true if a whole response was received
+ */
+bool receiveResponse(int connection, DaemonResponse *response) {
+    return recv(connection, response, sizeof(DaemonResponse), 0) == sizeof(DaemonResponse);
+}
@@ -0,0 +1,124 @@
+#!/bin/sh
+
+# Exercises the hashing daemon protocol end to end: starts a daemon on a
+# temporary socket, runs clients against it, and compares the digests with
+# res/correct_hashes.txt and sha256sum.  Then runs misbehaving clients
+# (test/hostile_client.c) against it, and checks that the daemon rejects
+# them without leaking descriptors.  Run from the src directory.
+
+TEST_DIR=$(mktemp -d)
+OUTPUT_BINARY=$TEST_DIR/sha256_summer
+HOSTILE_BINARY=$TEST_DIR/hostile_client
+SOCKET_PATH=$TEST_DIR/daemon.sock
+FAILURES=0
+
+gcc -o $OUTPUT_BINARY ./*.c -lpthread && gcc -o $HOSTILE_BINARY ./test/hostile_client.c
+
+if [ "$?" -ne 0 ]; then
+    echo "Build failed."
+    rm -rf $TEST_DIR
+    exit 1
+fi
+
+# Reports the result of a single test
+checkResult() {
+    if [ "$2" -eq 0 ]; then
+        echo "PASS: $1"
+    else
+        echo "FAIL: $1"
+        FAILURES=$((FAILURES + 1))
+    fi
+}
+
+$OUTPUT_BINARY --daemon $SOCKET_PATH &
+DAEMON_PID=$!
+
+# Wait for the daemon to start listening
+for i in 1 2 3 4 5 6 7 8 9 10; do
+    if [ -S "$SOCKET_PATH" ]; then
+        break
+    fi
+    sleep 0.1
+done
+
+cd ../res
+
+# The socket is only accessible to its owner
+[ "$(stat -c %a $SOCKET_PATH)" = "600" ]
+checkResult "socket permissions" $?
+
+# Path requests, compared with the known hashes
+$OUTPUT_BINARY --client $SOCKET_PATH ./test_file1.txt ./test_file2.txt ./test_file3.txt \
+    > $TEST_DIR/paths.txt
+cmp -s $TEST_DIR/paths.txt ./correct_hashes.txt
+checkResult "path requests" $?
+
+# Stdin, passed to the daemon as a sealed memfd
+EXPECTED=$(sha256sum < ./test_file2.txt | cut -c1-64)
+ACTUAL=$($OUTPUT_BINARY --client $SOCKET_PATH - < ./test_file2.txt | cut -c1-64)
+[ "$EXPECTED" = "$ACTUAL" ]
+checkResult "stdin memfd request" $?
+
+# Empty stdin
+EXPECTED=$(printf '' | sha256sum | cut -c1-64)
+ACTUAL=$(printf '' | $OUTPUT_BINARY --client $SOCKET_PATH - | cut -c1-64)
+[ "$EXPECTED" = "$ACTUAL" ]
+checkResult "empty memfd request" $?
+
+# A bad path fails on its own, without affecting the rest of the batch
+$OUTPUT_BINARY --client $SOCKET_PATH ./test_file1.txt ./missing_file.txt ./test_file3.txt \
+    > $TEST_DIR/bad_path.txt
+CLIENT_RESULT=$?
+[ "$CLIENT_RESULT" -eq 3 ] &&
+    grep -q "^Error hashing file: ./missing_file.txt$" $TEST_DIR/bad_path.txt &&
+    grep -q "test_file1.txt" $TEST_DIR/bad_path.txt &&
+    grep -q "test_file3.txt" $TEST_DIR/bad_path.txt
+checkResult "bad path request" $?
+
+# More paths than fit in one batch, sent as several batches on one connection
+seq 2500 | sed "s|.*|./test_file3.txt|" | xargs -x $OUTPUT_BINARY --client $SOCKET_PATH \
+    > $TEST_DIR/batches.txt
+[ "$(grep -c . $TEST_DIR/batches.txt)" -eq 2500 ] &&
+    [ "$(sort -u $TEST_DIR/batches.txt)" = "$(grep test_file3.txt ./correct_hashes.txt)" ]
+checkResult "multiple batches on one connection" $?
+
+# Misbehaving clients.  The daemon should reject each of them, keep serving
+# other clients, and not be left holding any of their descriptors.
+FD_COUNT_BEFORE=$(ls /proc/$DAEMON_PID/fd | wc -l)
+
+$HOSTILE_BINARY truncate $SOCKET_PATH
+checkResult "memfd truncated while hashing" $?
+
+EXPECTED=$(sha256sum < ./test_file3.txt | cut -c1-64)
+ACTUAL=$($HOSTILE_BINARY unsealed $SOCKET_PATH < ./test_file3.txt)
+[ "$EXPECTED" = "$ACTUAL" ]
+checkResult "unsealed memfd read rather than mapped" $?
+
+for SCENARIO in overlong unknown-type over-cap extra-fds missing-fd fd-on-path fd-on-end; do
+    $HOSTILE_BINARY $SCENARIO $SOCKET_PATH
+    checkResult "$SCENARIO rejected" $?
+done
+
+# Give the connection threads a moment to finish closing
+sleep 0.5
+FD_COUNT_AFTER=$(ls /proc/$DAEMON_PID/fd | wc -l)
+[ "$FD_COUNT_BEFORE" -eq "$FD_COUNT_AFTER" ]
+checkResult "no descriptors leaked ($FD_COUNT_BEFORE before, $FD_COUNT_AFTER after)" $?
+
+[ "$($OUTPUT_BINARY --client $SOCKET_PATH ./test_file1.txt)" = \
+    "$(grep test_file1.txt ./correct_hashes.txt)" ]
+checkResult "daemon still serving" $?
+
+# Stopping the daemon removes its socket
+kill $DAEMON_PID
+wait $DAEMON_PID 2> /dev/null
+[ ! -e "$SOCKET_PATH" ]
+checkResult "socket removed on exit" $?
+
+rm -rf $TEST_DIR
+
+if [ "$FAILURES" -ne 0 ]; then
+    echo "$FAILURES test(s) failed."
+    exit 1
+fi
+echo "All tests passed."
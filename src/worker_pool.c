@@ -0,0 +1,161 @@
+/**
+ * File:       worker_pool.c
+ * Author:     Franklyn Dahlberg
+ * Created:    18 October, 2026
+ * Copyright:  2026 (c) Franklyn Dahlberg
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "worker_pool.h"
+
+/**
+ * Worker thread main.  Pulls jobs off of the queue and runs them until
+ * the pool is shut down and the queue is empty.
+ *
+ * @param poolArg the WorkerPool this thread belongs to
+ */
+static void* workerThreadMain(void *poolArg) {
+    WorkerPool *pool = (WorkerPool*)poolArg;
+
+    pthread_mutex_lock(&pool->lock);
+    while (true) {
+        while (pool->queueCount == 0 && !pool->shuttingDown) {
+            pthread_cond_wait(&pool->jobAvailable, &pool->lock);
+        }
+        if (pool->queueCount == 0 && pool->shuttingDown) {
+            break;
+        }
+
+        WorkerJob job = pool->jobQueue[pool->queueHead];
+        pool->queueHead = (pool->queueHead + 1) % pool->queueCapacity;
+        pool->queueCount--;
+        pthread_cond_signal(&pool->slotAvailable);
+
+        // Run the job without holding the lock
+        pthread_mutex_unlock(&pool->lock);
+        job.jobFunc(job.jobArg);
+        pthread_mutex_lock(&pool->lock);
+
+        pool->jobsInFlight--;
+        if (pool->jobsInFlight == 0) {
+            pthread_cond_broadcast(&pool->allJobsDone);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+/**
+ * Returns the number of worker threads to use if the caller has no
+ * preference, which is one per online CPU.
+ */
+int workerPoolDefaultThreadCount() {
+    long cpuCount = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpuCount < 1) {
+        return 1;
+    }
+    return (int)cpuCount;
+}
+
+/**
+ * Initializes the param pool and starts its worker threads.  Exits the
+ * program if the threads or queue can't be created.
+ *
+ * @param pool pool to initialize
+ * @param threadCount number of worker threads to start
+ * @param queueCapacity number of jobs that can be queued before
+ *                      workerPoolSubmit blocks
+ */
+void workerPoolCreate(WorkerPool *pool, int threadCount, int queueCapacity) {
+    pool->threadCount = threadCount;
+    pool->queueCapacity = queueCapacity;
+    pool->queueHead = 0;
+    pool->queueCount = 0;
+    pool->jobsInFlight = 0;
+    pool->shuttingDown = false;
+
+    pool->threads = malloc(sizeof(pthread_t) * threadCount);
+    pool->jobQueue = malloc(sizeof(WorkerJob) * queueCapacity);
+    if (pool->threads == NULL || pool->jobQueue == NULL) {
+        printf("Error allocating worker pool.\nExiting.\n\n");
+        exit(4);
+    }
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->jobAvailable, NULL);
+    pthread_cond_init(&pool->slotAvailable, NULL);
+    pthread_cond_init(&pool->allJobsDone, NULL);
+
+    for (int i = 0; i < threadCount; i++) {
+        if (pthread_create(&pool->threads[i], NULL, workerThreadMain, pool) != 0) {
+            printf("Error starting worker thread.\nExiting.\n\n");
+            exit(4);
+        }
+    }
+}
+
+/**
+ * Queues a job on the param pool, blocking while the queue is full.
+ *
+ * @param pool pool to run the job on
+ * @param jobFunc function to run
+ * @param jobArg argument to pass to the function
+ */
+void workerPoolSubmit(WorkerPool *pool, WorkerJobFunc jobFunc, void *jobArg) {
+    pthread_mutex_lock(&pool->lock);
+    while (pool->queueCount == pool->queueCapacity) {
+        pthread_cond_wait(&pool->slotAvailable, &pool->lock);
+    }
+
+    int queueTail = (pool->queueHead + pool->queueCount) % pool->queueCapacity;
+    pool->jobQueue[queueTail].jobFunc = jobFunc;
+    pool->jobQueue[queueTail].jobArg = jobArg;
+    pool->queueCount++;
+    pool->jobsInFlight++;
+
+    pthread_cond_signal(&pool->jobAvailable);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * Blocks until every job submitted to the param pool has finished running.
+ *
+ * @param pool pool to wait on
+ */
+void workerPoolWait(WorkerPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    while (pool->jobsInFlight > 0) {
+        pthread_cond_wait(&pool->allJobsDone, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * Finishes any queued jobs, stops the worker threads and frees the pool.
+ *
+ * @param pool pool to destroy
+ */
+void workerPoolDestroy(WorkerPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->shuttingDown = true;
+    pthread_cond_broadcast(&pool->jobAvailable);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->threadCount; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->jobAvailable);
+    pthread_cond_destroy(&pool->slotAvailable);
+    pthread_cond_destroy(&pool->allJobsDone);
+
+    free(pool->threads);
+    free(pool->jobQueue);
+}
@@ -0,0 +1,46 @@
+/**
+ * File:       worker_pool.h
+ * Author:     Franklyn Dahlberg
+ * Created:    18 October, 2026
+ * Copyright:  2026 (c) Franklyn Dahlberg
+ */
+
+#pragma once
+#include <pthread.h>
+#include <stdbool.h>
+
+// A job is just a function to run on a worker thread and the argument to
+// pass it.  The job owns its argument, the pool never frees it.
+typedef void (*WorkerJobFunc)(void *jobArg);
+
+typedef struct _WorkerJob {
+    WorkerJobFunc jobFunc;
+    void *jobArg;
+} WorkerJob;
+
+// A fixed set of threads pulling jobs off of a bounded queue.  The queue
+// being bounded means a fast producer (eg. a file reader) blocks rather
+// than buffering an unbounded amount of data ahead of the hashing.
+typedef struct _WorkerPool {
+    pthread_t *threads;
+    int threadCount;
+
+    WorkerJob *jobQueue;         // Ring buffer of queued jobs
+    int queueCapacity;
+    int queueHead;
+    int queueCount;
+    int jobsInFlight;            // Jobs queued or currently running
+    bool shuttingDown;
+
+    pthread_mutex_t lock;
+    pthread_cond_t jobAvailable;
+    pthread_cond_t slotAvailable;
+    pthread_cond_t allJobsDone;
+} WorkerPool;
+
+// Function declarations
+int workerPoolDefaultThreadCount();
+void workerPoolCreate(WorkerPool *pool, int threadCount, int queueCapacity);
+void workerPoolSubmit(WorkerPool *pool, WorkerJobFunc jobFunc, void *jobArg);
+void workerPoolWait(WorkerPool *pool);
+void workerPoolDestroy(WorkerPool *pool);